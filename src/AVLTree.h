@@ -1,7 +1,7 @@
 #pragma once
-#include <queue>
 #include <iostream>
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <stdexcept>
 #include <vector>
@@ -12,9 +12,25 @@
  * We also expose:
  *   - public: Node* FindMin() const
  *   - public: int GetHeight() const
- *   - public: void LevelOrder(std::function<void(const T&)> f) const
+ *   - public: template <class F> void Traverse(TraversalOrder order, F&& f) const
+ *     (and InOrder/PreOrder/PostOrder/ReverseInOrder/LevelOrder(F&& f) shortcuts)
+ *   - public: Cursor Begin(TraversalOrder order) const - resumable traversal
+ *   - public: static AVLTree FromSorted(values, comparator) - O(n) bulk build
+ * Trees own their nodes: they can be moved but not copied.
+ *
+ * Traversals are iterative and never modify the tree. Depth-first orders use a fixed
+ * stack of MaxDepth entries (AVL height is at most ~1.44 * log2(n)) and never allocate.
+ * Level order is the one order that needs a queue, and it has three forms:
+ *   - LevelOrder(f) / Traverse(LevelOrder, f): O(n) over a block queue whose first
+ *     64 slots are inline. It allocates only when the queue outgrows them, and then
+ *     holds about as many slots as the live queue (never all n nodes).
+ *   - LevelOrder(f, buffer): O(n) over a caller-owned vector that ends up holding all n
+ *     nodes. Fastest when the buffer is reused, but it is an explicit opt-in.
+ *   - Begin(LevelOrder): never allocates, at the cost of O(n * h) node visits.
  */
 
+enum class TraversalOrder { InOrder, PreOrder, PostOrder, ReverseInOrder, LevelOrder };
+
 template <class T, class Compare = std::less<T>>
 class AVLTree {
 public:
@@ -26,7 +42,184 @@ public:
         Node(const T& val) : value(val), left(nullptr), right(nullptr), height(1) {}
     };
 
+    // Height bound for any tree that fits in memory: 1.44 * log2(2^64) < 93
+    static constexpr int MaxDepth = 96;
+
+    // Resumable traversal: Next() returns the next value in the chosen order, or nullptr
+    // at the end. The cursor only holds a fixed stack; inserting into or removing from
+    // the tree invalidates it.
+    class Cursor {
+    public:
+        Cursor(const Node* root, TraversalOrder order)
+            : root(root), order(order), size(0), current(nullptr), last(nullptr), level(0) {
+            if (!root) return;
+            switch (order) {
+                case TraversalOrder::InOrder: pushLeftSpine(root); break;
+                case TraversalOrder::ReverseInOrder: pushRightSpine(root); break;
+                case TraversalOrder::PostOrder: current = root; break;
+                case TraversalOrder::PreOrder:
+                case TraversalOrder::LevelOrder: push(root, 0); break;
+            }
+        }
+
+        const T* Next() {
+            const Node* node = nextNode();
+            return node ? &node->value : nullptr;
+        }
+
+    private:
+        const Node* root;
+        TraversalOrder order;
+        const Node* stack[MaxDepth];
+        int depth[MaxDepth];
+        int size;
+        const Node* current; // PostOrder: subtree still to descend into
+        const Node* last;    // PostOrder: last node emitted
+        int level;           // LevelOrder: depth currently being emitted
+
+        void push(const Node* node, int d) {
+            stack[size] = node;
+            depth[size] = d;
+            ++size;
+        }
+
+        void pushLeftSpine(const Node* node) {
+            for (; node; node = node->left) push(node, 0);
+        }
+
+        void pushRightSpine(const Node* node) {
+            for (; node; node = node->right) push(node, 0);
+        }
+
+        const Node* nextNode() {
+            switch (order) {
+                case TraversalOrder::InOrder: {
+                    if (size == 0) return nullptr;
+                    const Node* node = stack[--size];
+                    pushLeftSpine(node->right);
+                    return node;
+                }
+                case TraversalOrder::ReverseInOrder: {
+                    if (size == 0) return nullptr;
+                    const Node* node = stack[--size];
+                    pushRightSpine(node->left);
+                    return node;
+                }
+                case TraversalOrder::PreOrder: {
+                    if (size == 0) return nullptr;
+                    const Node* node = stack[--size];
+                    if (node->right) push(node->right, 0);
+                    if (node->left) push(node->left, 0);
+                    return node;
+                }
+                case TraversalOrder::PostOrder:
+                    while (current || size > 0) {
+                        if (current) {
+                            push(current, 0);
+                            current = current->left;
+                            continue;
+                        }
+                        const Node* top = stack[size - 1];
+                        if (top->right && top->right != last) {
+                            current = top->right;
+                        } else {
+                            --size;
+                            last = top;
+                            return top;
+                        }
+                    }
+                    return nullptr;
+                case TraversalOrder::LevelOrder:
+                    // One depth-limited DFS per level instead of a queue: no allocation,
+                    // but every level re-walks the levels above it, so O(n * h) node visits.
+                    // LevelOrder(f) is the O(n) path when the traversal need not be paused.
+                    while (root) {
+                        while (size > 0) {
+                            --size;
+                            const Node* node = stack[size];
+                            int d = depth[size];
+                            if (d == level) return node;
+                            if (node->right) push(node->right, d + 1);
+                            if (node->left) push(node->left, d + 1);
+                        }
+                        if (++level >= root->height) return nullptr;
+                        push(root, 0);
+                    }
+                    return nullptr;
+            }
+            return nullptr;
+        }
+    };
+
 private:
+    // FIFO of node pointers for LevelOrder: a chain of fixed-size blocks where drained
+    // blocks are recycled for new pushes, so memory follows the live queue length. The
+    // first block is inline, so levels up to BlockSize wide need no heap allocation.
+    class NodeQueue {
+        static constexpr int BlockSize = 64;
+
+        struct Block {
+            const Node* items[BlockSize];
+            Block* next;
+        };
+
+        Block inlineBlock;
+        Block* head;
+        Block* tail;
+        Block* spare; // drained blocks, reused before allocating
+        int headPos;
+        int tailPos;
+
+        void release(Block* block) {
+            while (block) {
+                Block* next = block->next;
+                if (block != &inlineBlock) delete block;
+                block = next;
+            }
+        }
+
+    public:
+        NodeQueue() : head(&inlineBlock), tail(&inlineBlock), spare(nullptr), headPos(0), tailPos(0) {
+            inlineBlock.next = nullptr;
+        }
+
+        ~NodeQueue() {
+            release(head);
+            release(spare);
+        }
+
+        NodeQueue(const NodeQueue&) = delete;
+        NodeQueue& operator=(const NodeQueue&) = delete;
+
+        bool Empty() const {
+            return head == tail && headPos == tailPos;
+        }
+
+        void Push(const Node* node) {
+            if (tailPos == BlockSize) {
+                Block* block = spare;
+                if (block) spare = block->next;
+                else block = new Block;
+                block->next = nullptr;
+                tail->next = block;
+                tail = block;
+                tailPos = 0;
+            }
+            tail->items[tailPos++] = node;
+        }
+
+        const Node* Pop() {
+            if (headPos == BlockSize) {
+                Block* drained = head;
+                head = head->next;
+                headPos = 0;
+                drained->next = spare;
+                spare = drained;
+            }
+            return head->items[headPos++];
+        }
+    };
+
     Node* root;
     Compare comp;
 
@@ -136,6 +329,17 @@ private:
         return balance(node);
     }
 
+    // Builds a perfectly balanced subtree from values[l, r) in O(r - l)
+    Node* buildSorted(const std::vector<T>& values, std::size_t l, std::size_t r) {
+        if (l >= r) return nullptr;
+        std::size_t m = l + (r - l) / 2;
+        Node* node = new Node(values[m]);
+        node->left = buildSorted(values, l, m);
+        node->right = buildSorted(values, m + 1, r);
+        updateHeight(node);
+        return node;
+    }
+
     void destroy(Node* node) {
         if (node) {
             destroy(node->left);
@@ -144,31 +348,34 @@ private:
         }
     }
 
-    void inorder(Node* node, std::function<void(const T&)> f) const {
-        if (!node) return;
-        inorder(node->left, f);
-        f(node->value);
-        inorder(node->right, f);
-    }
+public:
+    AVLTree() : root(nullptr), comp(Compare()) {}
+    explicit AVLTree(const Compare& comparator) : root(nullptr), comp(comparator) {}
+    ~AVLTree() { destroy(root); }
 
-    void preorder(Node* node, std::function<void(const T&)> f) const {
-        if (!node) return;
-        f(node->value);
-        preorder(node->left, f);
-        preorder(node->right, f);
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+
+    AVLTree(AVLTree&& other) noexcept : root(other.root), comp(std::move(other.comp)) {
+        other.root = nullptr;
     }
 
-    void postorder(Node* node, std::function<void(const T&)> f) const {
-        if (!node) return;
-        postorder(node->left, f);
-        postorder(node->right, f);
-        f(node->value);
+    AVLTree& operator=(AVLTree&& other) noexcept {
+        if (this != &other) {
+            destroy(root);
+            root = other.root;
+            comp = std::move(other.comp);
+            other.root = nullptr;
+        }
+        return *this;
     }
 
-public:
-    AVLTree() : root(nullptr), comp(Compare()) {}
-    explicit AVLTree(const Compare& comparator) : root(nullptr), comp(comparator) {}
-    ~AVLTree() { destroy(root); }
+    // Bulk build from values that are strictly increasing under comparator (no re-balancing needed)
+    static AVLTree FromSorted(const std::vector<T>& values, const Compare& comparator = Compare()) {
+        AVLTree tree(comparator);
+        tree.root = tree.buildSorted(values, 0, values.size());
+        return tree;
+    }
 
     // Insert a value using the stored comparator
     void Insert(const T& value) {
@@ -210,67 +417,90 @@ public:
         return false;
     }
 
-    // Public InOrder, PreOrder, PostOrder
-    void InOrder(std::function<void(const T&)> f) const { inorder(root, f); }
-    void PreOrder(std::function<void(const T&)> f) const { preorder(root, f); }
-    void PostOrder(std::function<void(const T&)> f) const { postorder(root, f); }
-
-    // Public LevelOrder
-    void LevelOrder(std::function<void(const T&)> f) const {
-        if (!root) return;
-
-        std::queue<Node*> q;
-        q.push(root);
-        while (!q.empty()) {
-            Node* current = q.front();
-            q.pop();
-            f(current->value);
-            if (current->left)  q.push(current->left);
-            if (current->right) q.push(current->right);
+    // Visits values with lo <= value <= hi in order, skipping subtrees outside the range
+    template <class F>
+    void Range(const T& lo, const T& hi, F&& f) const {
+        const Node* stack[MaxDepth];
+        int size = 0;
+        const Node* node = root;
+        while (true) {
+            while (node) {
+                if (comp(node->value, lo)) {
+                    node = node->right;
+                } else {
+                    stack[size++] = node;
+                    node = node->left;
+                }
+            }
+            if (size == 0) return;
+            const Node* top = stack[--size];
+            if (comp(hi, top->value)) return;
+            f(top->value);
+            node = top->right;
         }
     }
 
-    // Public ReverseInOrder
-    void ReverseInOrder(std::function<void(const T&)> f) const {
-        // In-order but right subtree first
-        std::function<void(Node*)> rev = [&](Node* node) {
-            if (!node) return;
-            rev(node->right);
-            f(node->value);
-            rev(node->left);
-        };
-        rev(root);
+    Cursor Begin(TraversalOrder order) const {
+        return Cursor(root, order);
     }
 
-    // Morris InOrder (still private-like; can expose if needed)
-    void MorrisInOrder(std::function<void(const T&)> f) const {
-        Node* current = root;
-        while (current) {
-            if (!current->left) {
+    template <class F>
+    void Traverse(TraversalOrder order, F&& f) const {
+        if (order == TraversalOrder::LevelOrder) {
+            NodeQueue queue;
+            if (root) queue.Push(root);
+            while (!queue.Empty()) {
+                const Node* current = queue.Pop();
                 f(current->value);
-                current = current->right;
-            } else {
-                Node* predecessor = current->left;
-                while (predecessor->right && predecessor->right != current) {
-                    predecessor = predecessor->right;
-                }
-                if (!predecessor->right) {
-                    predecessor->right = current;
-                    current = current->left;
-                } else {
-                    predecessor->right = nullptr;
-                    f(current->value);
-                    current = current->right;
-                }
+                if (current->left)  queue.Push(current->left);
+                if (current->right) queue.Push(current->right);
             }
+            return;
+        }
+        Cursor cursor(root, order);
+        while (const T* value = cursor.Next()) {
+            f(*value);
+        }
+    }
+
+    // Public InOrder, PreOrder, PostOrder
+    template <class F> void InOrder(F&& f) const { Traverse(TraversalOrder::InOrder, f); }
+    template <class F> void PreOrder(F&& f) const { Traverse(TraversalOrder::PreOrder, f); }
+    template <class F> void PostOrder(F&& f) const { Traverse(TraversalOrder::PostOrder, f); }
+
+    // Public LevelOrder with a caller-owned buffer: opt-in speed path. The buffer is cleared
+    // and used as the queue without popping, so it grows to all n node pointers; passing
+    // the same buffer across calls avoids reallocating it
+    template <class F>
+    void LevelOrder(F&& f, std::vector<const Node*>& buffer) const {
+        buffer.clear();
+        if (root) buffer.push_back(root);
+        for (std::size_t head = 0; head < buffer.size(); ++head) {
+            const Node* current = buffer[head];
+            f(current->value);
+            if (current->left)  buffer.push_back(current->left);
+            if (current->right) buffer.push_back(current->right);
         }
     }
 
+    // Public LevelOrder: O(n), allocates only for levels wider than NodeQueue's inline block
+    template <class F> void LevelOrder(F&& f) const { Traverse(TraversalOrder::LevelOrder, f); }
+
+    // Public ReverseInOrder
+    template <class F> void ReverseInOrder(F&& f) const { Traverse(TraversalOrder::ReverseInOrder, f); }
+
+    // Kept for compatibility: no longer threads right pointers, same as InOrder
+    template <class F> void MorrisInOrder(F&& f) const { InOrder(f); }
+
     // Public accessor for the minimal node pointer (or nullptr if empty)
     Node* FindMin() const {
         return findMin(root);
     }
 
+    const Compare& GetComparator() const {
+        return comp;
+    }
+
     // Public accessor for the tree's height (height of root)
     int GetHeight() const {
         return getHeight(root);
@@ -279,5 +509,10 @@ public:
     bool IsEmpty() const {
         return root == nullptr;
     }
+
+    void Clear() {
+        destroy(root);
+        root = nullptr;
+    }
 };
 
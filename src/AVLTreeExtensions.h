@@ -1,42 +1,34 @@
 #pragma once
 #include "AVLTree.h"
+#include "AVLTreePipeline.h"
 #include <functional>
+#include <utility>
 #include <vector>
 
+// Map/Where run as one fused traversal and bulk-build the result (see AVLTreePipeline.h)
 template <class T, class R>
-AVLTree<R>* Map(const AVLTree<T>& tree, std::function<R(const T&)> func) {
-    AVLTree<R>* result = new AVLTree<R>();
-    tree.InOrder([&](const T& value) {
-        result->Insert(func(value));
-    });
-    return result;
+AVLTree<R> Map(const AVLTree<T>& tree, std::function<R(const T&)> func) {
+    return tree | map(std::move(func)) | to_tree();
 }
 
 template <class T>
-AVLTree<T>* Where(const AVLTree<T>& tree, std::function<bool(const T&)> predicate) {
-    AVLTree<T>* result = new AVLTree<T>();
-    tree.InOrder([&](const T& value) {
-        if (predicate(value)) result->Insert(value);
-    });
-    return result;
+AVLTree<T> Where(const AVLTree<T>& tree, std::function<bool(const T&)> predicate) {
+    return tree | where(std::move(predicate)) | to_tree();
 }
 
 template <class T, class R>
 R Reduce(const AVLTree<T>& tree, std::function<R(const R&, const T&)> func, R initial) {
-    tree.InOrder([&](const T& val) {
-        initial = func(initial, val);
-    });
-    return initial;
+    return tree | reduce(std::move(func), std::move(initial));
 }
 
 template <class T>
-AVLTree<T>* ExtractSubtree(const AVLTree<T>& tree, const T& key) {
-    AVLTree<T>* result = new AVLTree<T>();
+AVLTree<T> ExtractSubtree(const AVLTree<T>& tree, const T& key) {
+    AVLTree<T> result;
     bool found = false;
     tree.PreOrder([&](const T& value) {
-        if (found) result->Insert(value);
+        if (found) result.Insert(value);
         if (value == key) {
-            result->Insert(value);
+            result.Insert(value);
             found = true;
         }
     });
@@ -0,0 +1,208 @@
+#pragma once
+#include "AVLTree.h"
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Lazy pipelines over AVLTree:
+ *     tree | where(pred) | map(func) | reduce(op, initial)
+ * where/map only describe a view; nothing is traversed until a terminal stage
+ * (reduce, for_each, to_vector, to_tree) is applied. All stages are then fused
+ * into one in-order traversal of the source, without intermediate trees.
+ *
+ * to_tree() is the only stage that builds a tree. If the results are already
+ * sorted (e.g. after where), it is an O(n) bulk build via AVLTree::FromSorted;
+ * otherwise the results are sorted once first. Equal results keep the first one,
+ * as repeated Insert would. Views that keep the source values in source order
+ * (the tree itself, where) carry its comparator, and to_tree() without arguments
+ * reuses it; after map the default is std::less of the new value type.
+ *
+ * Views refer to the source tree and must not outlive it.
+ */
+
+// A view is ordered by a known comparator if it exposes compare_type/comparator()
+template <class V, class = void> struct HasComparator : std::false_type {};
+template <class V> struct HasComparator<V, std::void_t<typename V::compare_type>> : std::true_type {};
+
+// Passes Up's compare_type through to views that keep its order
+template <class Up, bool = HasComparator<Up>::value> struct KeepsOrderOf {};
+template <class Up> struct KeepsOrderOf<Up, true> { using compare_type = typename Up::compare_type; };
+
+template <class T, class Compare>
+class TreeView {
+public:
+    using value_type = T;
+    using compare_type = Compare;
+
+    explicit TreeView(const AVLTree<T, Compare>& tree) : tree(&tree) {}
+
+    const Compare& comparator() const { return tree->GetComparator(); }
+
+    template <class Sink>
+    void Run(Sink&& sink) const {
+        tree->InOrder(sink);
+    }
+
+private:
+    const AVLTree<T, Compare>* tree;
+};
+
+template <class Up, class Pred>
+class WhereView : public KeepsOrderOf<Up> {
+public:
+    using value_type = typename Up::value_type;
+
+    WhereView(Up up, Pred pred) : up(std::move(up)), pred(std::move(pred)) {}
+
+    // Filtering keeps the upstream order, so the upstream comparator still applies
+    template <class U = Up>
+    const typename U::compare_type& comparator() const { return up.comparator(); }
+
+    template <class Sink>
+    void Run(Sink&& sink) const {
+        up.Run([&](const value_type& value) {
+            if (pred(value)) sink(value);
+        });
+    }
+
+private:
+    Up up;
+    Pred pred;
+};
+
+template <class Up, class Func>
+class MapView {
+public:
+    using value_type = std::decay_t<std::invoke_result_t<const Func&, const typename Up::value_type&>>;
+
+    MapView(Up up, Func func) : up(std::move(up)), func(std::move(func)) {}
+
+    template <class Sink>
+    void Run(Sink&& sink) const {
+        up.Run([&](const typename Up::value_type& value) { sink(func(value)); });
+    }
+
+private:
+    Up up;
+    Func func;
+};
+
+template <class V> struct IsPipelineView : std::false_type {};
+template <class T, class C> struct IsPipelineView<TreeView<T, C>> : std::true_type {};
+template <class U, class P> struct IsPipelineView<WhereView<U, P>> : std::true_type {};
+template <class U, class F> struct IsPipelineView<MapView<U, F>> : std::true_type {};
+
+// Sorts (only if needed) and drops equivalent values, then bulk-builds the tree
+template <class T, class Compare>
+AVLTree<T, Compare> MaterializeTree(std::vector<T> values, const Compare& comp) {
+    if (!std::is_sorted(values.begin(), values.end(), comp)) {
+        std::stable_sort(values.begin(), values.end(), comp);
+    }
+    auto last = std::unique(values.begin(), values.end(),
+                            [&](const T& a, const T& b) { return !comp(a, b); });
+    values.erase(last, values.end());
+    return AVLTree<T, Compare>::FromSorted(values, comp);
+}
+
+// ---- Stages ----
+
+template <class Pred>
+struct WhereStage {
+    Pred pred;
+    template <class Up>
+    WhereView<Up, Pred> Apply(Up up) const { return WhereView<Up, Pred>(std::move(up), pred); }
+};
+
+template <class Func>
+struct MapStage {
+    Func func;
+    template <class Up>
+    MapView<Up, Func> Apply(Up up) const { return MapView<Up, Func>(std::move(up), func); }
+};
+
+template <class Op, class R>
+struct ReduceStage {
+    Op op;
+    R initial;
+    template <class Up>
+    R Apply(const Up& up) const {
+        R acc = initial;
+        up.Run([&](const typename Up::value_type& value) { acc = op(acc, value); });
+        return acc;
+    }
+};
+
+template <class Func>
+struct ForEachStage {
+    Func func;
+    template <class Up>
+    void Apply(const Up& up) const {
+        up.Run([&](const typename Up::value_type& value) { func(value); });
+    }
+};
+
+struct ToVectorStage {
+    template <class Up>
+    std::vector<typename Up::value_type> Apply(const Up& up) const {
+        std::vector<typename Up::value_type> out;
+        up.Run([&](const typename Up::value_type& value) { out.push_back(value); });
+        return out;
+    }
+};
+
+// Compare = void means the view's own comparator if it has one, else std::less of its value type
+template <class Compare = void>
+struct ToTreeStage {
+    Compare comp;
+    template <class Up>
+    AVLTree<typename Up::value_type, Compare> Apply(const Up& up) const {
+        return MaterializeTree(ToVectorStage().Apply(up), comp);
+    }
+};
+
+template <>
+struct ToTreeStage<void> {
+    template <class Up>
+    auto Apply(const Up& up) const {
+        if constexpr (HasComparator<Up>::value) {
+            return MaterializeTree(ToVectorStage().Apply(up), up.comparator());
+        } else {
+            return MaterializeTree(ToVectorStage().Apply(up), std::less<typename Up::value_type>());
+        }
+    }
+};
+
+template <class Pred>
+WhereStage<std::decay_t<Pred>> where(Pred&& pred) { return {std::forward<Pred>(pred)}; }
+
+template <class Func>
+MapStage<std::decay_t<Func>> map(Func&& func) { return {std::forward<Func>(func)}; }
+
+template <class Op, class R>
+ReduceStage<std::decay_t<Op>, R> reduce(Op&& op, R initial) { return {std::forward<Op>(op), std::move(initial)}; }
+
+template <class Func>
+ForEachStage<std::decay_t<Func>> for_each(Func&& func) { return {std::forward<Func>(func)}; }
+
+inline ToVectorStage to_vector() { return {}; }
+
+inline ToTreeStage<> to_tree() { return {}; }
+
+template <class Compare>
+ToTreeStage<Compare> to_tree(Compare comp) { return {std::move(comp)}; }
+
+// ---- Composition ----
+
+template <class T, class Compare, class Stage>
+auto operator|(const AVLTree<T, Compare>& tree, const Stage& stage)
+    -> decltype(stage.Apply(TreeView<T, Compare>(tree))) {
+    return stage.Apply(TreeView<T, Compare>(tree));
+}
+
+template <class View, class Stage, class = std::enable_if_t<IsPipelineView<View>::value>>
+auto operator|(View view, const Stage& stage) -> decltype(stage.Apply(std::move(view))) {
+    return stage.Apply(std::move(view));
+}
@@ -6,15 +6,9 @@
 #include <unordered_map>
 #include <vector>
 
-enum class TraversalOrder { InOrder, PreOrder, PostOrder };
-
 template <class T>
 void Traverse(const AVLTree<T>& tree, TraversalOrder order, std::function<void(const T&)> f) {
-    switch (order) {
-        case TraversalOrder::InOrder: tree.InOrder(f); break;
-        case TraversalOrder::PreOrder: tree.PreOrder(f); break;
-        case TraversalOrder::PostOrder: tree.PostOrder(f); break;
-    }
+    tree.Traverse(order, f);
 }
 
 template <class T>
@@ -32,24 +26,23 @@ std::string ToStringTemplate(const AVLTree<T>& tree, const std::string& pattern)
 }
 
 template <class T>
-AVLTree<T>* FromOrderTemplate(const std::vector<T>& values, const std::string& pattern) {
-    AVLTree<T>* tree = new AVLTree<T>();
+AVLTree<T> FromOrderTemplate(const std::vector<T>& values, const std::string& pattern) {
+    AVLTree<T> tree;
     if (pattern == "KLP") {
-        for (const T& val : values) tree->Insert(val);
+        for (const T& val : values) tree.Insert(val);
     } else if (pattern == "LKP") {
         std::function<void(int, int)> build = [&](int l, int r) {
             if (l > r) return;
             int m = (l + r) / 2;
-            tree->Insert(values[m]);
+            tree.Insert(values[m]);
             build(l, m - 1);
             build(m + 1, r);
         };
         build(0, values.size() - 1);
     } else if (pattern == "LPK") {
         for (auto it = values.rbegin(); it != values.rend(); ++it)
-            tree->Insert(*it);
+            tree.Insert(*it);
     } else {
-        delete tree;
         throw std::invalid_argument("Unsupported pattern");
     }
     return tree;
@@ -78,12 +71,7 @@ bool HasSubtree(const AVLTree<T>& tree, const AVLTree<T>& sub) {
     tree.PreOrder([&](const T& v) { values.push_back(v); });
 
     for (const T& rootCandidate : values) {
-        auto candidate = ExtractSubtree(tree, rootCandidate);
-        if (IsSameTree(*candidate, sub)) {
-            delete candidate;
-            return true;
-        }
-        delete candidate;
+        if (IsSameTree(ExtractSubtree(tree, rootCandidate), sub)) return true;
     }
     return false;
 }
\ No newline at end of file
@@ -0,0 +1,325 @@
+#pragma once
+#include "AVLTree.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Non-interactive mode of main, for scripted replay and load testing:
+ *     main --batch [file|-] [--load snapshot] [--timing]
+ * The whole command stream (file, or stdin for "-" / no file) is read at once and
+ * parsed in place. One command per line, '#' starts a comment:
+ *     insert v...   remove v...   contains v   range lo hi
+ *     dump [in|pre|post|rev|level]   height   clear   save path   load path
+ * Results go through a single OutputBuffer on stdout. Errors are reported as
+ * "error <line>: <message>" and do not stop the run, but make the exit code 1.
+ * With --timing, the wall time of every command is written to stderr at the end.
+ *
+ * Snapshot format (native byte order): "AVLS", uint32 version = 1, uint64 count,
+ * then count int32 values in increasing order. Loading is an O(n) bulk build.
+ */
+
+// Buffered writer over a FILE*: values are formatted with to_chars into one buffer
+class OutputBuffer {
+    std::FILE* file;
+    std::string buffer;
+
+    static constexpr std::size_t FlushThreshold = 1 << 16;
+
+public:
+    explicit OutputBuffer(std::FILE* file) : file(file) {
+        buffer.reserve(FlushThreshold + 256);
+    }
+
+    ~OutputBuffer() { Flush(); }
+
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    OutputBuffer& Write(std::string_view text) {
+        buffer.append(text.data(), text.size());
+        if (buffer.size() >= FlushThreshold) Flush();
+        return *this;
+    }
+
+    OutputBuffer& Write(char c) {
+        buffer.push_back(c);
+        if (buffer.size() >= FlushThreshold) Flush();
+        return *this;
+    }
+
+    template <class Int>
+    OutputBuffer& WriteInt(Int value) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        return Write(std::string_view(digits, result.ptr - digits));
+    }
+
+    void Flush() {
+        if (!buffer.empty()) {
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+            buffer.clear();
+        }
+        std::fflush(file);
+    }
+};
+
+inline bool ReadWholeFile(std::FILE* file, std::string& out) {
+    char chunk[1 << 16];
+    std::size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        out.append(chunk, n);
+    }
+    return !std::ferror(file);
+}
+
+static_assert(sizeof(int) == sizeof(std::int32_t), "snapshots store int values as int32");
+
+inline bool SaveSnapshot(const AVLTree<int>& tree, const std::string& path) {
+    std::vector<std::int32_t> values;
+    tree.InOrder([&](int v) { values.push_back(v); });
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    std::uint32_t version = 1;
+    std::uint64_t count = values.size();
+    bool ok = std::fwrite("AVLS", 1, 4, file) == 4 &&
+              std::fwrite(&version, sizeof(version), 1, file) == 1 &&
+              std::fwrite(&count, sizeof(count), 1, file) == 1 &&
+              std::fwrite(values.data(), sizeof(std::int32_t), values.size(), file) == values.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+// Replaces tree with the snapshot contents; on failure the tree is left unchanged
+inline bool LoadSnapshot(AVLTree<int>& tree, const std::string& path, std::string& error) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    char magic[4];
+    std::uint32_t version = 0;
+    std::uint64_t count = 0;
+    bool ok = std::fread(magic, 1, 4, file) == 4 && std::memcmp(magic, "AVLS", 4) == 0 &&
+              std::fread(&version, sizeof(version), 1, file) == 1 && version == 1 &&
+              std::fread(&count, sizeof(count), 1, file) == 1;
+    std::vector<int> values;
+    if (ok) {
+        // Values are read up to EOF and only then checked against count, so a corrupt count
+        // can neither overflow a size computation nor over-allocate, and no (32-bit on
+        // MinGW) long file offsets are involved
+        values.reserve(std::size_t(std::min<std::uint64_t>(count, 1u << 20)));
+        std::int32_t chunk[1 << 14];
+        std::size_t n;
+        while (ok && (n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            ok = n % sizeof(std::int32_t) == 0 &&
+                 values.size() + n / sizeof(std::int32_t) <= count;
+            if (ok) values.insert(values.end(), chunk, chunk + n / sizeof(std::int32_t));
+        }
+        ok = ok && !std::ferror(file) && values.size() == count;
+    }
+    std::fclose(file);
+    if (!ok) {
+        error = "bad snapshot " + path;
+        return false;
+    }
+    for (std::size_t i = 1; i < values.size(); ++i) {
+        if (values[i - 1] >= values[i]) {
+            error = "snapshot values are not strictly increasing";
+            return false;
+        }
+    }
+    tree = AVLTree<int>::FromSorted(values);
+    return true;
+}
+
+class BatchRunner {
+public:
+    struct Timing {
+        std::size_t line;
+        std::string_view command;
+        long long nanoseconds;
+    };
+
+    BatchRunner(AVLTree<int>& tree, OutputBuffer& out, bool timing)
+        : tree(tree), out(out), timing(timing), errors(0) {}
+
+    // Runs every command of script; returns the number of failed commands
+    std::size_t Run(std::string_view script) {
+        std::size_t lineNumber = 0;
+        while (!script.empty()) {
+            std::size_t end = script.find('\n');
+            std::string_view line = script.substr(0, end);
+            script.remove_prefix(end == std::string_view::npos ? script.size() : end + 1);
+            ++lineNumber;
+
+            std::size_t hash = line.find('#');
+            if (hash != std::string_view::npos) line = line.substr(0, hash);
+            tokens.clear();
+            Tokenize(line, tokens);
+            if (tokens.empty()) continue;
+
+            auto start = std::chrono::steady_clock::now();
+            std::string_view message = Execute();
+            if (!message.empty()) {
+                ++errors;
+                out.Write("error ").WriteInt(lineNumber).Write(": ").Write(message).Write('\n');
+            }
+            if (timing) {
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                timings.push_back({lineNumber, tokens[0],
+                                   std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()});
+            }
+        }
+        return errors;
+    }
+
+    void ReportTimings(OutputBuffer& report) const {
+        long long total = 0;
+        for (const Timing& t : timings) {
+            report.WriteInt(t.line).Write('\t').Write(t.command).Write('\t').WriteInt(t.nanoseconds).Write(" ns\n");
+            total += t.nanoseconds;
+        }
+        report.Write("total\t").WriteInt(timings.size()).Write(" commands\t").WriteInt(total).Write(" ns\n");
+    }
+
+private:
+    AVLTree<int>& tree;
+    OutputBuffer& out;
+    bool timing;
+    std::size_t errors;
+    std::vector<std::string_view> tokens;
+    std::vector<Timing> timings;
+    std::string loadError;
+
+    static void Tokenize(std::string_view line, std::vector<std::string_view>& tokens) {
+        std::size_t i = 0;
+        while (i < line.size()) {
+            while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+            std::size_t start = i;
+            while (i < line.size() && line[i] != ' ' && line[i] != '\t' && line[i] != '\r') ++i;
+            if (i > start) tokens.push_back(line.substr(start, i - start));
+        }
+    }
+
+    static bool ParseInt(std::string_view token, int& value) {
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+        return result.ec == std::errc() && result.ptr == token.data() + token.size();
+    }
+
+    void WriteValue(int v) {
+        out.WriteInt(v).Write(' ');
+    }
+
+    // Returns an error message, or an empty view on success
+    std::string_view Execute() {
+        std::string_view cmd = tokens[0];
+        std::size_t argc = tokens.size() - 1;
+        int a = 0, b = 0;
+
+        if (cmd == "insert" || cmd == "remove") {
+            if (argc == 0) return "expected at least one value";
+            for (std::size_t i = 1; i <= argc; ++i) {
+                if (!ParseInt(tokens[i], a)) return "invalid integer";
+                if (cmd == "insert") tree.Insert(a);
+                else tree.Remove(a);
+            }
+        } else if (cmd == "contains") {
+            if (argc != 1 || !ParseInt(tokens[1], a)) return "usage: contains <value>";
+            out.Write(tree.Contains(a) ? "1\n" : "0\n");
+        } else if (cmd == "range") {
+            if (argc != 2 || !ParseInt(tokens[1], a) || !ParseInt(tokens[2], b)) return "usage: range <lo> <hi>";
+            tree.Range(a, b, [&](int v) { WriteValue(v); });
+            out.Write('\n');
+        } else if (cmd == "dump") {
+            TraversalOrder order = TraversalOrder::InOrder;
+            std::string_view name = argc > 0 ? tokens[1] : "in";
+            if (argc > 1) return "usage: dump [in|pre|post|rev|level]";
+            if (name == "in") order = TraversalOrder::InOrder;
+            else if (name == "pre") order = TraversalOrder::PreOrder;
+            else if (name == "post") order = TraversalOrder::PostOrder;
+            else if (name == "rev") order = TraversalOrder::ReverseInOrder;
+            else if (name == "level") order = TraversalOrder::LevelOrder;
+            else return "usage: dump [in|pre|post|rev|level]";
+            tree.Traverse(order, [&](int v) { WriteValue(v); });
+            out.Write('\n');
+        } else if (cmd == "height") {
+            if (argc != 0) return "usage: height";
+            out.WriteInt(tree.GetHeight()).Write('\n');
+        } else if (cmd == "clear") {
+            if (argc != 0) return "usage: clear";
+            tree.Clear();
+        } else if (cmd == "save") {
+            if (argc != 1) return "usage: save <path>";
+            if (!SaveSnapshot(tree, std::string(tokens[1]))) return "cannot write snapshot";
+        } else if (cmd == "load") {
+            if (argc != 1) return "usage: load <path>";
+            if (!LoadSnapshot(tree, std::string(tokens[1]), loadError)) return loadError;
+        } else {
+            return "unknown command";
+        }
+        return {};
+    }
+};
+
+// Entry point for "main --batch ..."; returns the process exit code
+inline int RunBatchMode(int argc, char** argv) {
+    const char* scriptPath = "-";
+    const char* snapshotPath = nullptr;
+    bool timing = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "--batch") {
+            if (i + 1 < argc && argv[i + 1][0] != '-') scriptPath = argv[++i];
+            else if (i + 1 < argc && std::string_view(argv[i + 1]) == "-") ++i;
+        } else if (arg == "--load" && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else if (arg == "--timing") {
+            timing = true;
+        } else {
+            std::fprintf(stderr, "usage: %s --batch [file|-] [--load snapshot] [--timing]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    AVLTree<int> tree;
+    if (snapshotPath) {
+        std::string error;
+        if (!LoadSnapshot(tree, snapshotPath, error)) {
+            std::fprintf(stderr, "error: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    std::string script;
+    bool fromStdin = std::strcmp(scriptPath, "-") == 0;
+    std::FILE* input = fromStdin ? stdin : std::fopen(scriptPath, "rb");
+    if (!input) {
+        std::fprintf(stderr, "error: cannot open %s\n", scriptPath);
+        return 1;
+    }
+    bool readOk = ReadWholeFile(input, script);
+    if (!fromStdin) std::fclose(input);
+    if (!readOk) {
+        std::fprintf(stderr, "error: cannot read %s\n", scriptPath);
+        return 1;
+    }
+
+    OutputBuffer out(stdout);
+    BatchRunner runner(tree, out, timing);
+    std::size_t errors = runner.Run(script);
+    out.Flush();
+
+    if (timing) {
+        OutputBuffer report(stderr);
+        runner.ReportTimings(report);
+    }
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include "PersonTypes.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+/*
+ * PersonRegistry stores every record exactly once and keeps several intrusive
+ * AVL indexes over the same storage:
+ *   - PersonIndex::ByID        : (series, number), unique
+ *   - PersonIndex::ByName      : (lastName, firstName, middleName), ties broken by ID
+ *   - PersonIndex::ByBirthDate : (year, month, day), ties broken by ID
+ *
+ * Records live in a std::deque arena, so their addresses never move; each record
+ * carries its own left/right/height links for every index. Insert and Remove
+ * link/unlink a record in all indexes at once, and removed slots are reused.
+ */
+
+enum class PersonIndex { ByID = 0, ByName = 1, ByBirthDate = 2 };
+
+template <class P = Person>
+class PersonRegistry {
+    static constexpr int IndexCount = 3;
+
+    struct Record;
+
+    struct Link {
+        Record* left;
+        Record* right;
+        int height;
+    };
+
+    struct Record {
+        P person;
+        Link links[IndexCount];
+    };
+
+    std::deque<Record> arena;
+    std::vector<Record*> freeSlots;
+    Record* roots[IndexCount];
+    std::size_t count;
+
+    static int compareID(const PersonID& a, const PersonID& b) {
+        std::uint64_t x = a.Packed(), y = b.Packed();
+        if (x == y) return 0;
+        return x < y ? -1 : 1;
+    }
+
+    // Interned names: equal IDs mean equal strings, so only differing IDs are compared as text
+    static int compareNameID(NameID a, NameID b) {
+        if (a == b) return 0;
+        const NamePool& pool = NamePool::Shared();
+        return pool.Get(a).compare(pool.Get(b));
+    }
+
+    static int compareName(const P& a, const P& b) {
+        if (int c = compareNameID(a.GetLastNameID(), b.GetLastNameID())) return c;
+        if (int c = compareNameID(a.GetFirstNameID(), b.GetFirstNameID())) return c;
+        return compareNameID(a.GetMiddleNameID(), b.GetMiddleNameID());
+    }
+
+    static int compareDate(PackedDate a, PackedDate b) {
+        if (a == b) return 0;
+        return a < b ? -1 : 1;
+    }
+
+    // Total order of index idx; the ID tie-break keeps every key unique.
+    static int compare(int idx, const P& a, const P& b) {
+        int c = 0;
+        if (idx == int(PersonIndex::ByName)) c = compareName(a, b);
+        else if (idx == int(PersonIndex::ByBirthDate)) c = compareDate(a.GetPackedBirthDate(), b.GetPackedBirthDate());
+        return c ? c : compareID(a.GetID(), b.GetID());
+    }
+
+    static int getHeight(int idx, Record* node) {
+        return node ? node->links[idx].height : 0;
+    }
+
+    static void updateHeight(int idx, Record* node) {
+        Link& l = node->links[idx];
+        l.height = 1 + std::max(getHeight(idx, l.left), getHeight(idx, l.right));
+    }
+
+    static int getBalance(int idx, Record* node) {
+        return getHeight(idx, node->links[idx].left) - getHeight(idx, node->links[idx].right);
+    }
+
+    static Record* rotateRight(int idx, Record* y) {
+        Record* x = y->links[idx].left;
+        y->links[idx].left = x->links[idx].right;
+        x->links[idx].right = y;
+        updateHeight(idx, y);
+        updateHeight(idx, x);
+        return x;
+    }
+
+    static Record* rotateLeft(int idx, Record* x) {
+        Record* y = x->links[idx].right;
+        x->links[idx].right = y->links[idx].left;
+        y->links[idx].left = x;
+        updateHeight(idx, x);
+        updateHeight(idx, y);
+        return y;
+    }
+
+    static Record* balance(int idx, Record* node) {
+        updateHeight(idx, node);
+        int balanceFactor = getBalance(idx, node);
+        Link& l = node->links[idx];
+
+        // Left-heavy
+        if (balanceFactor > 1) {
+            if (getBalance(idx, l.left) < 0) l.left = rotateLeft(idx, l.left);
+            return rotateRight(idx, node);
+        }
+        // Right-heavy
+        if (balanceFactor < -1) {
+            if (getBalance(idx, l.right) > 0) l.right = rotateRight(idx, l.right);
+            return rotateLeft(idx, node);
+        }
+        return node;
+    }
+
+    static Record* link(int idx, Record* node, Record* rec) {
+        if (!node) {
+            rec->links[idx] = Link{nullptr, nullptr, 1};
+            return rec;
+        }
+        Link& l = node->links[idx];
+        if (compare(idx, rec->person, node->person) < 0) l.left = link(idx, l.left, rec);
+        else l.right = link(idx, l.right, rec);
+        return balance(idx, node);
+    }
+
+    // Detaches the leftmost record of the subtree and returns it through min.
+    static Record* unlinkMin(int idx, Record* node, Record*& min) {
+        Link& l = node->links[idx];
+        if (!l.left) {
+            min = node;
+            return l.right;
+        }
+        l.left = unlinkMin(idx, l.left, min);
+        return balance(idx, node);
+    }
+
+    // Records are relinked rather than copied, so no other index is disturbed.
+    static Record* unlink(int idx, Record* node, Record* rec) {
+        if (!node) return nullptr;
+        Link& l = node->links[idx];
+        if (node == rec) {
+            if (!l.left || !l.right) return l.left ? l.left : l.right;
+            Record* min = nullptr;
+            Record* rest = unlinkMin(idx, l.right, min);
+            min->links[idx].left = l.left;
+            min->links[idx].right = rest;
+            return balance(idx, min);
+        }
+        if (compare(idx, rec->person, node->person) < 0) l.left = unlink(idx, l.left, rec);
+        else l.right = unlink(idx, l.right, rec);
+        return balance(idx, node);
+    }
+
+    Record* findByID(const PersonID& id) const {
+        const int idx = int(PersonIndex::ByID);
+        Record* current = roots[idx];
+        while (current) {
+            int c = compareID(id, current->person.GetID());
+            if (c == 0) return current;
+            current = c < 0 ? current->links[idx].left : current->links[idx].right;
+        }
+        return nullptr;
+    }
+
+    // In-order walk of index idx, pruned to keys that are neither below nor above the range.
+    template <class Below, class Above, class F>
+    static void rangeWalk(int idx, Record* node, const Below& below, const Above& above, F& f) {
+        if (!node) return;
+        const Link& l = node->links[idx];
+        bool isBelow = below(node->person);
+        bool isAbove = above(node->person);
+        if (!isBelow) rangeWalk(idx, l.left, below, above, f);
+        if (!isBelow && !isAbove) f(node->person);
+        if (!isAbove) rangeWalk(idx, l.right, below, above, f);
+    }
+
+public:
+    PersonRegistry() : roots{nullptr, nullptr, nullptr}, count(0) {}
+
+    // Indexes point into the arena, so a registry cannot be copied
+    PersonRegistry(const PersonRegistry&) = delete;
+    PersonRegistry& operator=(const PersonRegistry&) = delete;
+
+    // Adds the record to every index. Returns false (and changes nothing) if the ID is taken.
+    bool Insert(const P& person) {
+        if (findByID(person.GetID())) return false;
+
+        Record* rec;
+        if (!freeSlots.empty()) {
+            rec = freeSlots.back();
+            freeSlots.pop_back();
+            rec->person = person;
+        } else {
+            arena.push_back(Record{person, {}});
+            rec = &arena.back();
+        }
+
+        for (int idx = 0; idx < IndexCount; ++idx) {
+            roots[idx] = link(idx, roots[idx], rec);
+        }
+        ++count;
+        return true;
+    }
+
+    // Removes the record with the given ID from every index. Returns false if it is absent.
+    bool Remove(const PersonID& id) {
+        Record* rec = findByID(id);
+        if (!rec) return false;
+
+        for (int idx = 0; idx < IndexCount; ++idx) {
+            roots[idx] = unlink(idx, roots[idx], rec);
+        }
+        rec->person = P();
+        freeSlots.push_back(rec);
+        --count;
+        return true;
+    }
+
+    // Pointer into the arena (stable until the record is removed), or nullptr
+    const P* Find(const PersonID& id) const {
+        Record* rec = findByID(id);
+        return rec ? &rec->person : nullptr;
+    }
+
+    bool Contains(const PersonID& id) const {
+        return findByID(id) != nullptr;
+    }
+
+    // Visits all records in the order of the selected index
+    template <class F>
+    void ForEach(PersonIndex index, F f) const {
+        int idx = int(index);
+        rangeWalk(idx, roots[idx],
+                  [](const P&) { return false; },
+                  [](const P&) { return false; }, f);
+    }
+
+    // Records with lo <= ID <= hi, in ID order
+    template <class F>
+    void RangeByID(const PersonID& lo, const PersonID& hi, F f) const {
+        int idx = int(PersonIndex::ByID);
+        rangeWalk(idx, roots[idx],
+                  [&](const P& p) { return compareID(p.GetID(), lo) < 0; },
+                  [&](const P& p) { return compareID(hi, p.GetID()) < 0; }, f);
+    }
+
+    // Records with loLast <= lastName <= hiLast, in name order
+    template <class F>
+    void RangeByLastName(const std::string& loLast, const std::string& hiLast, F f) const {
+        int idx = int(PersonIndex::ByName);
+        rangeWalk(idx, roots[idx],
+                  [&](const P& p) { return p.GetLastName().compare(loLast) < 0; },
+                  [&](const P& p) { return hiLast.compare(p.GetLastName()) < 0; }, f);
+    }
+
+    // Records born between lo and hi inclusive (year/month/day only), in date order
+    template <class F>
+    void RangeByBirthDate(const std::tm& lo, const std::tm& hi, F f) const {
+        int idx = int(PersonIndex::ByBirthDate);
+        PackedDate from = PackedDate::FromTm(lo), to = PackedDate::FromTm(hi);
+        rangeWalk(idx, roots[idx],
+                  [&](const P& p) { return p.GetPackedBirthDate() < from; },
+                  [&](const P& p) { return to < p.GetPackedBirthDate(); }, f);
+    }
+
+    std::size_t Size() const {
+        return count;
+    }
+
+    bool IsEmpty() const {
+        return count == 0;
+    }
+
+    // Height of the selected index tree
+    int GetHeight(PersonIndex index) const {
+        return getHeight(int(index), roots[int(index)]);
+    }
+};
@@ -1,35 +1,260 @@
 #pragma once
-#include <string>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+ * Person records are kept compact (24 bytes) so that trees of them stay cache-resident:
+ *   - names are interned in a shared NamePool and stored as 32-bit NameIDs
+ *   - the birth date is packed into 32 bits (PackedDate)
+ *   - PersonID is two 32-bit halves, also available as one 64-bit key
+ * The constructor and getters keep their string / std::tm forms for callers.
+ */
+
+using NameID = std::uint32_t;
+
+// Shared string pool: every distinct name is stored once. Interned strings are never freed,
+// and references returned by Get stay valid for the lifetime of the program.
+//
+// Safe to use from several threads: Intern takes a mutex, while Get is lock-free. Strings live
+// in chunks that double in size and are never moved or reallocated, and each chunk is
+// published with a release store, so readers never see storage that is being grown.
+class NamePool {
+    static constexpr unsigned FirstChunkBits = 6;                  // chunk k holds 64 << k names
+    static constexpr unsigned ChunkCount = 32 - FirstChunkBits + 1; // enough for every NameID
+
+    std::atomic<std::string*> chunks[ChunkCount];
+    std::atomic<std::size_t> count;
+    std::unordered_map<std::string_view, NameID> ids; // guarded by mutex
+    std::mutex mutex;
+
+    // Maps id to (chunk, offset): id + 64 has its top bit at position FirstChunkBits + chunk
+    static void locate(NameID id, unsigned& chunk, std::size_t& offset) {
+        std::uint64_t x = std::uint64_t(id) + (1u << FirstChunkBits);
+        chunk = 0;
+        while (x >> (FirstChunkBits + chunk + 1)) ++chunk;
+        offset = std::size_t(x - (std::uint64_t(1) << (FirstChunkBits + chunk)));
+    }
+
+    NamePool() : count(0) {
+        for (auto& chunk : chunks) chunk.store(nullptr, std::memory_order_relaxed);
+        Intern("");
+    }
+
+    ~NamePool() {
+        for (auto& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+    }
+
+public:
+    NamePool(const NamePool&) = delete;
+    NamePool& operator=(const NamePool&) = delete;
+
+    static NamePool& Shared() {
+        static NamePool pool;
+        return pool;
+    }
+
+    // Returns the existing ID of the string, or adds it to the pool. The empty string is ID 0.
+    NameID Intern(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+
+        NameID id = static_cast<NameID>(count.load(std::memory_order_relaxed));
+        unsigned chunk;
+        std::size_t offset;
+        locate(id, chunk, offset);
+        std::string* storage = chunks[chunk].load(std::memory_order_relaxed);
+        if (!storage) {
+            storage = new std::string[std::size_t(1) << (FirstChunkBits + chunk)];
+            chunks[chunk].store(storage, std::memory_order_release);
+        }
+        storage[offset].assign(name.data(), name.size());
+        ids.emplace(storage[offset], id);
+        count.store(std::size_t(id) + 1, std::memory_order_release);
+        return id;
+    }
+
+    const std::string& Get(NameID id) const {
+        unsigned chunk;
+        std::size_t offset;
+        locate(id, chunk, offset);
+        return chunks[chunk].load(std::memory_order_acquire)[offset];
+    }
+
+    std::size_t Size() const {
+        return count.load(std::memory_order_acquire);
+    }
+};
+
+// Year/month/day in 32 bits; comparing packed values compares dates.
+// Layout: [biased tm_year : 23][tm_mon : 4][tm_mday : 5]
+struct PackedDate {
+    std::uint32_t value = 0;
+
+    static constexpr std::int32_t YearBias = 1 << 22;
+
+    // Out-of-range tm_mon / tm_mday are normalized like mktime does (2000-12-32 is
+    // 2001-01-01, day 0 is the last day of the previous month), so every field fits
+    // its bits. Throws std::out_of_range if the resulting year cannot be packed.
+    static PackedDate FromTm(const std::tm& t) {
+        long long months = (long long)t.tm_year * 12 + t.tm_mon;
+        long long year = floorDiv(months, 12);
+        long long days = daysFromCivil(year + 1900, unsigned(months - year * 12) + 1, 1) + t.tm_mday - 1;
+
+        unsigned month = 0, day = 0;
+        civilFromDays(days, year, month, day);
+        year -= 1900;
+        if (year < -YearBias || year >= YearBias) {
+            throw std::out_of_range("PackedDate: year out of range");
+        }
+        return PackedDate{(std::uint32_t(year + YearBias) << 9) |
+                          (std::uint32_t(month - 1) << 5) |
+                          std::uint32_t(day)};
+    }
+
+    std::tm ToTm() const {
+        std::tm t{};
+        t.tm_year = Year();
+        t.tm_mon = Month();
+        t.tm_mday = Day();
+        return t;
+    }
+
+    int Year() const { return int(value >> 9) - YearBias; } // years since 1900, as in std::tm
+    int Month() const { return int((value >> 5) & 0xF); }   // 0..11
+    int Day() const { return int(value & 0x1F); }           // 1..31 (0 only in a default PackedDate)
+
+    bool operator==(const PackedDate& other) const { return value == other.value; }
+    bool operator<(const PackedDate& other) const { return value < other.value; }
+
+private:
+    static long long floorDiv(long long a, long long b) {
+        return a / b - ((a % b != 0) && ((a < 0) != (b < 0)));
+    }
+
+    // Proleptic Gregorian date <-> days since 1970-01-01 (H. Hinnant's algorithms)
+    static long long daysFromCivil(long long y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        long long era = floorDiv(y, 400);
+        unsigned yoe = unsigned(y - era * 400);
+        unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + (long long)doe - 719468;
+    }
+
+    static void civilFromDays(long long z, long long& y, unsigned& m, unsigned& d) {
+        z += 719468;
+        long long era = floorDiv(z, 146097);
+        unsigned doe = unsigned(z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = (long long)yoe + era * 400 + (m <= 2);
+    }
+};
 
 struct PersonID {
-    int series;
-    int number;
+    std::int32_t series;
+    std::int32_t number;
     bool operator==(const PersonID& other) const {
         return series == other.series && number == other.number;
     }
+    bool operator<(const PersonID& other) const {
+        return Packed() < other.Packed();
+    }
+
+    // 64-bit key ordered like (series, number)
+    std::uint64_t Packed() const {
+        return (std::uint64_t(std::uint32_t(series) ^ 0x80000000u) << 32) |
+               (std::uint32_t(number) ^ 0x80000000u);
+    }
+
+    static PersonID Unpack(std::uint64_t key) {
+        return PersonID{std::int32_t(std::uint32_t(key >> 32) ^ 0x80000000u),
+                        std::int32_t(std::uint32_t(key) ^ 0x80000000u)};
+    }
 };
 
 class Person {
 protected:
-    PersonID id;
-    std::string firstName, middleName, lastName;
-    std::tm birthDate;
+    PersonID id{};
+    NameID firstName = 0, middleName = 0, lastName = 0;
+    PackedDate birthDate;
 public:
     Person() = default;
 
-    Person(PersonID pid, std::string fn, std::string mn, std::string ln, std::tm dob)
-        : id(pid), firstName(fn), middleName(mn), lastName(ln), birthDate(dob) {}
+    Person(PersonID pid, std::string_view fn, std::string_view mn, std::string_view ln, const std::tm& dob)
+        : id(pid),
+          firstName(NamePool::Shared().Intern(fn)),
+          middleName(NamePool::Shared().Intern(mn)),
+          lastName(NamePool::Shared().Intern(ln)),
+          birthDate(PackedDate::FromTm(dob)) {}
 
     std::string GetFullName() const {
-        return firstName + " " + middleName + " " + lastName;
+        std::string out;
+        AppendFullName(out);
+        return out;
+    }
+
+    // Appends "first middle last" to out; allocates only if out lacks capacity
+    void AppendFullName(std::string& out) const {
+        const NamePool& pool = NamePool::Shared();
+        const std::string& fn = pool.Get(firstName);
+        const std::string& mn = pool.Get(middleName);
+        const std::string& ln = pool.Get(lastName);
+        out.reserve(out.size() + fn.size() + mn.size() + ln.size() + 2);
+        out.append(fn).append(1, ' ').append(mn).append(1, ' ').append(ln);
     }
 
+    // snprintf-style: writes at most cap - 1 chars plus '\0' into buf and
+    // returns the full length of the name, so a result >= cap means truncation
+    std::size_t FormatFullName(char* buf, std::size_t cap) const {
+        const NamePool& pool = NamePool::Shared();
+        const std::string* parts[3] = {&pool.Get(firstName), &pool.Get(middleName), &pool.Get(lastName)};
+        std::size_t length = 0;
+        for (int i = 0; i < 3; ++i) {
+            if (i > 0) {
+                if (length + 1 < cap) buf[length] = ' ';
+                ++length;
+            }
+            const std::string& part = *parts[i];
+            if (length + 1 < cap) {
+                std::memcpy(buf + length, part.data(), std::min(part.size(), cap - 1 - length));
+            }
+            length += part.size();
+        }
+        if (cap > 0) buf[std::min(length, cap - 1)] = '\0';
+        return length;
+    }
+
+    const std::string& GetFirstName() const { return NamePool::Shared().Get(firstName); }
+    const std::string& GetMiddleName() const { return NamePool::Shared().Get(middleName); }
+    const std::string& GetLastName() const { return NamePool::Shared().Get(lastName); }
+
+    NameID GetFirstNameID() const { return firstName; }
+    NameID GetMiddleNameID() const { return middleName; }
+    NameID GetLastNameID() const { return lastName; }
+
     PersonID GetID() const { return id; }
 
-    std::tm GetBirthDate() const { return birthDate; }
+    std::tm GetBirthDate() const { return birthDate.ToTm(); }
+
+    PackedDate GetPackedBirthDate() const { return birthDate; }
 };
 
+static_assert(sizeof(Person) == 24, "Person is expected to stay packed");
+
 class Student : public Person {
 public:
     using Person::Person;
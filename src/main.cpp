@@ -1,11 +1,15 @@
 #include "AVLTree.h"
 #include "AVLTreeExtensions.h"
 #include "AVLTreeTraversalTemplates.h"
+#include "BatchMode.h"
 
 #include <iostream>
 #include <string>
 
-int main() {
+int main(int argc, char** argv) {
+    // Any command-line arguments select the non-interactive batch mode (see BatchMode.h)
+    if (argc > 1) return RunBatchMode(argc, argv);
+
     AVLTree<int> tree;
     int choice, value;
 
@@ -15,7 +19,7 @@ int main() {
         std::cout << "6. Map (×2)\n7. Where (x > n)\n8. Extract Subtree\n9. Compare trees\n";
         std::cout << "10. Save to template string\n11. Build from string and template\n";
         std::cout << "12. Traverse with selected order\n13. Exit\n> ";
-        std::cin >> choice;
+        if (!(std::cin >> choice)) return 0;
 
         switch (choice) {
             case 1:
@@ -33,20 +37,20 @@ int main() {
                 tree.PreOrder([](int v){ std::cout << v << " "; }); std::cout << "\n"; break;
             case 6: {
                 auto mapped = Map<int, int>(tree, [](int x){ return x * 2; });
-                mapped->InOrder([](int v){ std::cout << v << " "; }); std::cout << "\n";
-                delete mapped; break;
+                mapped.InOrder([](int v){ std::cout << v << " "; }); std::cout << "\n";
+                break;
             }
             case 7: {
                 std::cout << "Filter x > ? "; int n; std::cin >> n;
-                auto filtered = Where<int>(tree, [n](int x){ return x > n; });
-                filtered->InOrder([](int v){ std::cout << v << " "; }); std::cout << "\n";
-                delete filtered; break;
+                tree | where([n](int x){ return x > n; })
+                     | for_each([](int v){ std::cout << v << " "; });
+                std::cout << "\n"; break;
             }
             case 8: {
                 std::cout << "Subtree key: "; int k; std::cin >> k;
                 auto sub = ExtractSubtree(tree, k);
-                sub->InOrder([](int v){ std::cout << v << " "; }); std::cout << "\n";
-                delete sub; break;
+                sub.InOrder([](int v){ std::cout << v << " "; }); std::cout << "\n";
+                break;
             }
             case 9: {
                 AVLTree<int> other;
@@ -60,6 +64,7 @@ int main() {
                     other.Insert(x);
 
                 std::cout << (Equals(tree, other) ? "Trees are equal.\n" : "Trees are NOT equal.\n");
+                break;
             }
             case 10: {
                 std::string pattern;
@@ -81,14 +86,13 @@ int main() {
                 try {
                     auto values = ParseValuesFromString<int>(str);
                     auto built = FromOrderTemplate<int>(values, pattern);
-                    built->InOrder([](int v){ std::cout << v << " "; }); std::cout << "\n";
-                    delete built;
+                    built.InOrder([](int v){ std::cout << v << " "; }); std::cout << "\n";
                 } catch (std::exception& e) {
                     std::cout << "Error: " << e.what() << "\n";
                 }
                 break;
             }
-            case 13: {
+            case 12: {
                 std::string order;
                 std::cout << "Traversal (KLP, LKP, LPK): ";
                 std::cin >> order;
@@ -100,7 +104,7 @@ int main() {
                 Traverse<int>(tree, ord, [](int x){ std::cout << x << " "; });
                 std::cout << "\n"; break;
             }
-            case 14: return 0;
+            case 13: return 0;
         }
     }
 }
@@ -1,12 +1,20 @@
 #include "AVLTree.h"
+#include "AVLTreeExtensions.h"
+#include "AVLTreeTraversalTemplates.h"
+#include "BatchMode.h"
 #include "PersonTypes.h"
+#include "PersonRegistry.h"
 #include <cassert>
+#include <cstdint>
+#include <cstdio>
 #include <complex>
 #include <cmath>
 #include <vector>
 #include <string>
+#include <thread>
 #include <functional>
 #include <iostream>
+#include <stdexcept>
 
 // Simple functions for TestFunctionTree
 int FuncA(int x) { return x + 1; }
@@ -123,6 +131,175 @@ void TestPersonTree() {
     assert(teacherTree.Contains(t));
 }
 
+void TestCompactPerson() {
+    std::tm dob{};
+    dob.tm_year = 1987 - 1900;
+    dob.tm_mon = 11;
+    dob.tm_mday = 31;
+
+    Student a{{-5, 42}, "Ivan", "Ivanovich", "Ivanov", dob};
+    Teacher b{{7, -1}, "Ivan", "Petrovich", "Ivanov", dob};
+
+    // Одинаковые имена хранятся в пуле один раз
+    assert(a.GetFirstNameID() == b.GetFirstNameID());
+    assert(a.GetLastNameID() == b.GetLastNameID());
+    assert(a.GetMiddleNameID() != b.GetMiddleNameID());
+    assert(a.GetFullName() == "Ivan Ivanovich Ivanov");
+
+    std::tm back = a.GetBirthDate();
+    assert(back.tm_year == dob.tm_year && back.tm_mon == dob.tm_mon && back.tm_mday == dob.tm_mday);
+
+    std::tm later = dob;
+    later.tm_year += 1;
+    later.tm_mon = 0;
+    later.tm_mday = 1;
+    assert(PackedDate::FromTm(dob) < PackedDate::FromTm(later));
+
+    // Ненормализованный месяц переносится в год, а не портит битовые поля
+    std::tm overflow = dob;
+    overflow.tm_mon = 12;
+    overflow.tm_mday = 1;
+    assert(PackedDate::FromTm(overflow) == PackedDate::FromTm(later));
+    std::tm underflow = later;
+    underflow.tm_mon = -1;
+    underflow.tm_mday = 31;
+    assert(PackedDate::FromTm(underflow) == PackedDate::FromTm(dob));
+
+    // Выход дня за пределы месяца нормализуется как в mktime
+    std::tm dayOverflow = dob;
+    dayOverflow.tm_mday = 32;
+    bool normalized = PackedDate::FromTm(dayOverflow) == PackedDate::FromTm(later);
+    std::tm dayZero = later;
+    dayZero.tm_mday = 0;
+    normalized = normalized && PackedDate::FromTm(dayZero) == PackedDate::FromTm(dob);
+    std::tm dayNegative = later;
+    dayNegative.tm_mday = -1;
+    std::tm dec30 = dob;
+    dec30.tm_mday = 30;
+    normalized = normalized && PackedDate::FromTm(dayNegative) == PackedDate::FromTm(dec30);
+    std::tm leap{};
+    leap.tm_year = 2000 - 1900;
+    leap.tm_mon = 1;
+    leap.tm_mday = 30;
+    PackedDate march1 = PackedDate::FromTm(leap);
+    normalized = normalized && march1.Month() == 2 && march1.Day() == 1;
+    if (!normalized) throw std::logic_error("PackedDate normalization failed");
+
+    std::tm farFuture{};
+    farFuture.tm_year = (1 << 22) + 1;
+    bool threw = false;
+    try {
+        PackedDate::FromTm(farFuture);
+    } catch (const std::out_of_range&) {
+        threw = true;
+    }
+    if (!threw) throw std::logic_error("PackedDate accepted an unpackable year");
+
+    // 64-битный ключ сохраняет порядок (series, number) и для отрицательных значений
+    assert(a.GetID() < b.GetID());
+    assert((PersonID{1, -3} < PersonID{1, 2}));
+    assert(PersonID::Unpack(a.GetID().Packed()) == a.GetID());
+
+    // Форматирование без выделения памяти, с усечением как у snprintf
+    char buf[64];
+    assert(a.FormatFullName(buf, sizeof(buf)) == 21);
+    assert(std::string(buf) == "Ivan Ivanovich Ivanov");
+    char small[8];
+    assert(a.FormatFullName(small, sizeof(small)) == 21);
+    assert(std::string(small) == "Ivan Iv");
+}
+
+void TestNamePoolThreads() {
+    // Несколько потоков одновременно создают и читают записи с общими именами
+    std::tm dob{};
+    dob.tm_mday = 1;
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t, &dob, &failures] {
+            for (int i = 0; i < 2000; ++i) {
+                std::string first = "First" + std::to_string(i % 300);
+                std::string last = "Last" + std::to_string(t) + "_" + std::to_string(i);
+                Student s{{t, i}, first, "Middle", last, dob};
+                if (s.GetFirstName() != first || s.GetLastName() != last) ++failures[t];
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int f : failures) assert(f == 0);
+
+    // Одинаковые имена из разных потоков получили один и тот же ID
+    NameID a = NamePool::Shared().Intern("First7");
+    assert(NamePool::Shared().Get(a) == "First7");
+    assert(Student({0, 0}, "First7", "", "", dob).GetFirstNameID() == a);
+}
+
+void TestPersonRegistry() {
+    PersonRegistry<Student> registry;
+
+    auto date = [](int year, int mon, int day) {
+        std::tm d{};
+        d.tm_year = year - 1900;
+        d.tm_mon = mon;
+        d.tm_mday = day;
+        return d;
+    };
+
+    assert(registry.Insert(Student{{1000, 3}, "Petr", "Petrovich", "Petrov", date(2001, 5, 2)}));
+    assert(registry.Insert(Student{{1000, 1}, "Ivan", "Ivanovich", "Ivanov", date(2000, 1, 1)}));
+    assert(registry.Insert(Student{{1001, 2}, "Anna", "Sergeevna", "Smirnova", date(1999, 3, 8)}));
+    assert(registry.Insert(Student{{1000, 2}, "Oleg", "Ivanovich", "Ivanov", date(2000, 1, 1)}));
+
+    // Повторный ID отклоняется
+    assert(!registry.Insert(Student{{1000, 1}, "X", "Y", "Z", date(2000, 1, 1)}));
+    assert(registry.Size() == 4);
+
+    const Student* found = registry.Find({1001, 2});
+    assert(found && found->GetLastName() == "Smirnova");
+
+    // Каждый индекс задаёт свой порядок обхода
+    std::vector<int> byId, byName, byDate;
+    registry.ForEach(PersonIndex::ByID, [&](const Student& s) { byId.push_back(s.GetID().number); });
+    registry.ForEach(PersonIndex::ByName, [&](const Student& s) { byName.push_back(s.GetID().number); });
+    registry.ForEach(PersonIndex::ByBirthDate, [&](const Student& s) { byDate.push_back(s.GetID().number); });
+    assert((byId == std::vector<int>{1, 2, 3, 2}));
+    assert((byName == std::vector<int>{1, 2, 3, 2}));
+    assert((byDate == std::vector<int>{2, 1, 2, 3}));
+
+    std::vector<std::string> ivanovs;
+    registry.RangeByLastName("Ivanov", "Ivanov", [&](const Student& s) { ivanovs.push_back(s.GetFirstName()); });
+    assert((ivanovs == std::vector<std::string>{"Ivan", "Oleg"}));
+
+    int bornIn2000 = 0;
+    registry.RangeByBirthDate(date(2000, 0, 1), date(2000, 11, 31), [&](const Student&) { ++bornIn2000; });
+    assert(bornIn2000 == 2);
+
+    // Удаление убирает запись из всех индексов
+    assert(registry.Remove({1000, 1}));
+    assert(!registry.Remove({1000, 1}));
+    assert(!registry.Contains({1000, 1}));
+    int remaining = 0;
+    registry.RangeByID({0, 0}, {9999, 999999}, [&](const Student&) { ++remaining; });
+    assert(remaining == 3);
+    ivanovs.clear();
+    registry.RangeByLastName("Ivanov", "Ivanov", [&](const Student& s) { ivanovs.push_back(s.GetFirstName()); });
+    assert((ivanovs == std::vector<std::string>{"Oleg"}));
+
+    // Балансировка каждого индекса на большом числе записей
+    PersonRegistry<Teacher> teachers;
+    for (int i = 0; i < 1000; ++i) {
+        teachers.Insert(Teacher{{i % 7, i}, "T", "T", "Name" + std::to_string(999 - i), date(1950 + i % 40, i % 12, 1)});
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        teachers.Remove({i % 7, i});
+    }
+    assert(teachers.Size() == 500);
+    double bound = 1.44 * std::log2(500 + 2);
+    assert(teachers.GetHeight(PersonIndex::ByID) <= bound);
+    assert(teachers.GetHeight(PersonIndex::ByName) <= bound);
+    assert(teachers.GetHeight(PersonIndex::ByBirthDate) <= bound);
+}
+
 void TestFunctionTree() {
     // We store function pointers of type int(*)(int), compare by pointer address.
     using FuncType = int(*)(int);
@@ -162,14 +339,250 @@ void TestAdvancedFunctionality() {
     assert(tree.Contains(75));
 }
 
+void TestTraversals() {
+    AVLTree<int> tree;
+    for (int i = 1; i <= 7; ++i) tree.Insert(i); // идеальное дерево с корнем 4
+
+    auto collect = [&](TraversalOrder order) {
+        std::vector<int> out;
+        tree.Traverse(order, [&](int x) { out.push_back(x); });
+        return out;
+    };
+    assert((collect(TraversalOrder::InOrder) == std::vector<int>{1, 2, 3, 4, 5, 6, 7}));
+    assert((collect(TraversalOrder::ReverseInOrder) == std::vector<int>{7, 6, 5, 4, 3, 2, 1}));
+    assert((collect(TraversalOrder::PreOrder) == std::vector<int>{4, 2, 1, 3, 6, 5, 7}));
+    assert((collect(TraversalOrder::PostOrder) == std::vector<int>{1, 3, 2, 5, 7, 6, 4}));
+    assert((collect(TraversalOrder::LevelOrder) == std::vector<int>{4, 2, 6, 1, 3, 5, 7}));
+
+    // Курсор (без выделения памяти) и O(n) обход по уровням дают один порядок
+    std::vector<int> levelByCursor;
+    auto levelCursor = tree.Begin(TraversalOrder::LevelOrder);
+    while (const int* v = levelCursor.Next()) levelByCursor.push_back(*v);
+    assert(levelByCursor == collect(TraversalOrder::LevelOrder));
+    std::vector<const AVLTree<int>::Node*> buffer;
+    for (int pass = 0; pass < 2; ++pass) {
+        std::vector<int> levelByBuffer;
+        tree.LevelOrder([&](int x) { levelByBuffer.push_back(x); }, buffer);
+        assert(levelByBuffer == levelByCursor);
+    }
+
+    std::vector<int> morris;
+    tree.MorrisInOrder([&](int x) { morris.push_back(x); });
+    assert(morris == collect(TraversalOrder::InOrder));
+
+    // Курсор можно приостановить и продолжить
+    auto cursor = tree.Begin(TraversalOrder::PostOrder);
+    std::vector<int> resumed;
+    for (int i = 0; i < 3; ++i) resumed.push_back(*cursor.Next());
+    assert((resumed == std::vector<int>{1, 3, 2}));
+    while (const int* v = cursor.Next()) resumed.push_back(*v);
+    assert(resumed == collect(TraversalOrder::PostOrder));
+    assert(cursor.Next() == nullptr);
+
+    AVLTree<int> empty;
+    assert(empty.Begin(TraversalOrder::LevelOrder).Next() == nullptr);
+
+    std::vector<int> range;
+    tree.Range(3, 5, [&](int x) { range.push_back(x); });
+    assert((range == std::vector<int>{3, 4, 5}));
+    tree.Clear();
+    assert(tree.IsEmpty());
+
+    // Обходы большого несбалансированного по вставке дерева
+    AVLTree<int> large;
+    for (int i = 0; i < 10000; ++i) large.Insert((i * 7919) % 10000);
+    int expected = 0;
+    bool ordered = true;
+    large.InOrder([&](int x) { ordered = ordered && x == expected++; });
+    assert(ordered && expected == 10000);
+    int count = 0;
+    large.LevelOrder([&](int) { ++count; });
+    assert(count == 10000);
+    // Обход по уровням с очередью из блоков совпадает с буферным вариантом
+    std::vector<int> levelDefault, levelBuffered;
+    large.LevelOrder([&](int x) { levelDefault.push_back(x); });
+    std::vector<const AVLTree<int>::Node*> largeBuffer;
+    large.LevelOrder([&](int x) { levelBuffered.push_back(x); }, largeBuffer);
+    assert(levelDefault == levelBuffered);
+    count = 0;
+    large.PostOrder([&](int) { ++count; });
+    assert(count == 10000);
+}
+
+void TestPipeline() {
+    AVLTree<int> tree;
+    for (int i = 1; i <= 20; ++i) tree.Insert(i);
+
+    // Где -> Отобразить -> Свернуть за один обход
+    int sum = tree | where([](int x) { return x % 2 == 0; })
+                   | map([](int x) { return x * x; })
+                   | reduce([](int acc, int x) { return acc + x; }, 0);
+    assert(sum == 1540);
+
+    auto evens = tree | where([](int x) { return x % 2 == 0; }) | to_vector();
+    assert(evens.size() == 10 && evens.front() == 2 && evens.back() == 20);
+
+    // Материализация: отсортированный вход строится за O(n), несортированный сортируется
+    AVLTree<int> big = tree | where([](int x) { return x > 10; }) | to_tree();
+    assert(big.Contains(11) && big.Contains(20) && !big.Contains(10));
+    assert(big.FindMin()->value == 11);
+
+    AVLTree<int> mod = tree | map([](int x) { return (x * 7) % 5; }) | to_tree();
+    std::vector<int> modValues = mod | to_vector();
+    assert((modValues == std::vector<int>{0, 1, 2, 3, 4}));
+
+    auto desc = [](int a, int b) { return a > b; };
+    auto reversed = tree | map([](int x) { return x * 10; }) | to_tree(desc);
+    assert(reversed.FindMin()->value == 200);
+
+    // where | to_tree() сохраняет компаратор исходного дерева и строится за O(n)
+    int comparisons = 0;
+    auto countingDesc = [&comparisons](int a, int b) { ++comparisons; return a > b; };
+    AVLTree<int, decltype(countingDesc)> descTree(countingDesc);
+    for (int i = 0; i < 1000; ++i) descTree.Insert(i);
+    comparisons = 0;
+    AVLTree<int, decltype(countingDesc)> descEvens = descTree | where([](int x) { return x % 2 == 0; }) | to_tree();
+    assert(comparisons <= 2 * 500);
+    assert(descEvens.FindMin()->value == 998 && descEvens.Contains(0) && !descEvens.Contains(1));
+
+    auto personComp = [](const Student& a, const Student& b) { return a.GetID() < b.GetID(); };
+    AVLTree<Student, decltype(personComp)> studentTree(personComp);
+    std::tm dob{};
+    dob.tm_mday = 1;
+    for (int i = 0; i < 10; ++i) studentTree.Insert(Student{{1, i}, "S", "S", "S", dob});
+    auto selected = studentTree | where([](const Student& s) { return s.GetID().number >= 5; }) | to_tree();
+    assert(selected.FindMin()->value.GetID().number == 5);
+    assert(selected.Contains(Student{{1, 9}, "S", "S", "S", dob}));
+
+    // Map/Where возвращают дерево по значению
+    AVLTree<int> doubled = Map<int, int>(tree, [](const int& x) { return x * 2; });
+    assert(doubled.Contains(40) && !doubled.Contains(41));
+    AVLTree<int> filtered = Where<int>(tree, [](const int& x) { return x < 5; });
+    int filteredSum = Reduce<int, int>(filtered, [](const int& acc, const int& x) { return acc + x; }, 0);
+    assert(filteredSum == 10);
+
+    // ExtractSubtree/FromOrderTemplate тоже возвращают владеющие значения
+    AVLTree<int> built = FromOrderTemplate<int>({4, 2, 6, 1, 3, 5, 7}, "KLP");
+    assert(IsSameTree(built, FromOrderTemplate<int>({1, 2, 3, 4, 5, 6, 7}, "LKP")));
+    AVLTree<int> sub = ExtractSubtree(built, 6);
+    assert(sub.Contains(6) && sub.Contains(7) && !sub.Contains(2));
+    assert(HasSubtree(built, FromOrderTemplate<int>({7}, "KLP")));
+
+    AVLTree<int> moved = std::move(filtered);
+    assert(filtered.IsEmpty() && moved.Contains(4));
+
+    // Сбалансированность результата bulk-построения
+    AVLTree<int> large;
+    for (int i = 0; i < 1000; ++i) large.Insert(i);
+    AVLTree<int> copy = large | to_tree();
+    assert(copy.GetHeight() <= 1.44 * std::log2(1000 + 2));
+}
+
+// Runs script through BatchRunner and returns everything it wrote
+std::string RunBatchScript(AVLTree<int>& tree, const std::string& script, std::size_t& errors) {
+    std::FILE* file = std::tmpfile();
+    assert(file);
+    {
+        OutputBuffer out(file);
+        BatchRunner runner(tree, out, false);
+        errors = runner.Run(script);
+    }
+    std::rewind(file);
+    std::string output;
+    ReadWholeFile(file, output);
+    std::fclose(file);
+    return output;
+}
+
+void WriteRawSnapshot(const char* path, std::uint64_t count, const std::vector<std::int32_t>& values) {
+    std::FILE* file = std::fopen(path, "wb");
+    assert(file);
+    std::uint32_t version = 1;
+    std::fwrite("AVLS", 1, 4, file);
+    std::fwrite(&version, sizeof(version), 1, file);
+    std::fwrite(&count, sizeof(count), 1, file);
+    std::fwrite(values.data(), sizeof(std::int32_t), values.size(), file);
+    std::fclose(file);
+}
+
+void TestBatchMode() {
+    const char* snapshot = "batch_test_snapshot.bin";
+    AVLTree<int> tree;
+    std::size_t errors = 0;
+
+    std::string output = RunBatchScript(tree,
+        "# комментарий\n"
+        "insert 5 3 9 1 4 7 12\n"
+        "contains 4\n"
+        "contains 6   # не вставлялось\n"
+        "range 3 8\n"
+        "dump pre\n"
+        "dump level\n"
+        "\n"
+        "remove 3 12\n"
+        "dump\n"
+        "height\n"
+        "bogus\n"
+        "insert x\n"
+        "range 1\n"
+        "save " + std::string(snapshot) + "\n"
+        "clear\n"
+        "dump rev", errors);
+    assert(output ==
+        "1\n"
+        "0\n"
+        "3 4 5 7 \n"
+        "5 3 1 4 9 7 12 \n"
+        "5 3 9 1 4 7 12 \n"
+        "1 4 5 7 9 \n"
+        "3\n"
+        "error 12: unknown command\n"
+        "error 13: invalid integer\n"
+        "error 14: usage: range <lo> <hi>\n"
+        "\n");
+    assert(errors == 3);
+    assert(tree.IsEmpty());
+
+    // Сохранение -> загрузка даёт то же содержимое
+    std::string error;
+    assert(LoadSnapshot(tree, snapshot, error));
+    assert(((tree | to_vector()) == std::vector<int>{1, 4, 5, 7, 9}));
+    AVLTree<int> reloaded;
+    output = RunBatchScript(reloaded, "load " + std::string(snapshot) + "\ndump\n", errors);
+    assert(errors == 0 && output == "1 4 5 7 9 \n");
+
+    // Повреждённые снимки отклоняются, дерево не меняется
+    WriteRawSnapshot(snapshot, 3, {1, 2});
+    assert(!LoadSnapshot(tree, snapshot, error));
+    WriteRawSnapshot(snapshot, (std::uint64_t(1) << 62) + 1, {1});
+    assert(!LoadSnapshot(tree, snapshot, error));
+    WriteRawSnapshot(snapshot, 2, {2, 1});
+    assert(!LoadSnapshot(tree, snapshot, error));
+    WriteRawSnapshot(snapshot, 1, {1, 2});
+    assert(!LoadSnapshot(tree, snapshot, error));
+    assert(((tree | to_vector()) == std::vector<int>{1, 4, 5, 7, 9}));
+
+    output = RunBatchScript(tree, "load " + std::string(snapshot) + "\ndump\n", errors);
+    assert(errors == 1);
+    assert(output == "error 1: bad snapshot " + std::string(snapshot) + "\n1 4 5 7 9 \n");
+
+    std::remove(snapshot);
+}
+
 void RunAllTests() {
     TestIntTree();
     TestDoubleTree();
     TestComplexTree();
     TestStringTree();
     TestPersonTree();
+    TestCompactPerson();
+    TestNamePoolThreads();
+    TestPersonRegistry();
     TestFunctionTree();
     TestAdvancedFunctionality();
+    TestTraversals();
+    TestPipeline();
+    TestBatchMode();
 
     std::cout << "All tests passed successfully!\n";
 }